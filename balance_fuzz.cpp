@@ -0,0 +1,352 @@
+///////////////////////////////////////////////////////////////////////////////
+// balance_fuzz.cpp
+//
+// Differential fuzz target for the algorithms declared in balance.hpp .
+//
+// Every input is decoded into a vector of small ints, then each variant of
+// find_dip and longest_balanced_span is compared against a simple, obviously
+// correct reference implementation below. Any disagreement is a bug.
+//
+// This file builds two ways:
+//
+//   make balance_fuzz
+//     Standalone driver, no libFuzzer required. Replays the seed corpus,
+//     then generates pseudo-random inputs from a hardcoded seed. When a
+//     mismatch is found the input is shrunk before it is printed.
+//
+//       ./balance_fuzz [ITERATIONS] [MAX-LENGTH]
+//       ./balance_fuzz --throughput [SECONDS] [LENGTH]
+//       ./balance_fuzz --write-corpus <DIRECTORY>
+//
+//   make balance_fuzz_libfuzzer
+//     libFuzzer target (clang -fsanitize=fuzzer), run with
+//
+//       ./balance_fuzz_libfuzzer fuzz_corpus
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "timer.hpp"
+
+#include "balance.hpp"
+
+namespace reference {
+
+// Straightforward scan that remembers the last dip seen.
+std::vector<int>::const_iterator find_dip(const std::vector<int>& values) {
+  auto result = values.end();
+  for (size_t i = 0; i + 2 < values.size(); ++i) {
+    if ((values[i] == values[i+2]) && (values[i+1] < values[i])) {
+      result = values.begin() + i;
+    }
+  }
+  return result;
+}
+
+// O(n^2) search over every (begin, end) pair. Begins are visited in
+// increasing order and ties are replaced, so the LAST longest span wins.
+std::optional<balance::span> longest_balanced_span(const std::vector<int>& values) {
+  std::optional<balance::span> best;
+  for (size_t i = 0; i < values.size(); ++i) {
+    long long sum = 0;
+    for (size_t j = i; j < values.size(); ++j) {
+      sum += values[j];
+      if ((0 == sum) && (!best || ((j + 1 - i) >= best->size()))) {
+        best = balance::span(values.begin() + i, values.begin() + j + 1);
+      }
+    }
+  }
+  return best;
+}
+
+} // namespace reference
+
+// A variant of each algorithm under test. When an optimized rewrite keeps the
+// original around (or adds a second implementation), list it here so that it
+// is checked against the reference too.
+struct find_dip_variant {
+  const char* name;
+  std::function<std::vector<int>::const_iterator(const std::vector<int>&)> function;
+};
+
+struct longest_balanced_span_variant {
+  const char* name;
+  std::function<std::optional<balance::span>(const std::vector<int>&)> function;
+};
+
+const std::vector<find_dip_variant> find_dip_variants{
+  {"balance::find_dip", balance::find_dip},
+};
+
+const std::vector<longest_balanced_span_variant> longest_balanced_span_variants{
+  {"balance::longest_balanced_span", balance::longest_balanced_span},
+};
+
+// Decode raw fuzzer bytes into ints in the range [-10, +10], the same range
+// balance_test.cpp uses. A narrow range makes dips and balanced spans common.
+std::vector<int> decode(const uint8_t* data, size_t size) {
+  std::vector<int> values;
+  values.reserve(size);
+  for (size_t i = 0; i < size; ++i) {
+    values.push_back(int(data[i] % 21) - 10);
+  }
+  return values;
+}
+
+// Inverse of decode, used when writing the seed corpus.
+std::string encode(const std::vector<int>& values) {
+  std::string bytes;
+  for (int value : values) {
+    assert((value >= -10) && (value <= 10));
+    bytes.push_back(char(value + 10));
+  }
+  return bytes;
+}
+
+std::string describe(const std::vector<int>& values,
+                     std::vector<int>::const_iterator iter) {
+  if (iter == values.end()) {
+    return "end()";
+  }
+  return "begin()+" + std::to_string(iter - values.begin());
+}
+
+std::string describe(const std::vector<int>& values,
+                     const std::optional<balance::span>& got) {
+  if (!got) {
+    return "no span";
+  }
+  return "[" + std::to_string(got->begin() - values.begin()) + ", "
+       + std::to_string(got->end() - values.begin()) + ")";
+}
+
+// Return an empty string when every variant agrees with the reference on
+// values, otherwise a description of the first disagreement.
+std::string check(const std::vector<int>& values) {
+  auto expected_dip = reference::find_dip(values);
+  for (auto& variant : find_dip_variants) {
+    auto got = variant.function(values);
+    if (got != expected_dip) {
+      return std::string(variant.name) + " returned " + describe(values, got)
+           + ", expected " + describe(values, expected_dip);
+    }
+  }
+
+  auto expected_span = reference::longest_balanced_span(values);
+  for (auto& variant : longest_balanced_span_variants) {
+    auto got = variant.function(values);
+    if (bool(got) != bool(expected_span) || (got && !(*got == *expected_span))) {
+      return std::string(variant.name) + " returned " + describe(values, got)
+           + ", expected " + describe(values, expected_span);
+    }
+  }
+
+  return std::string();
+}
+
+// The name of the variant that check(values) blames, or an empty string.
+std::string culprit(const std::vector<int>& values) {
+  auto failure = check(values);
+  return failure.substr(0, failure.find(' '));
+}
+
+// Shrink a failing input by repeatedly deleting chunks of elements, then
+// pulling the remaining elements toward zero, as long as the same variant
+// still fails.
+std::vector<int> shrink(std::vector<int> values) {
+  auto original_culprit = culprit(values);
+  assert(!original_culprit.empty());
+  auto still_fails = [&](const std::vector<int>& candidate) {
+    return culprit(candidate) == original_culprit;
+  };
+  for (size_t chunk = values.size() / 2; chunk > 0; chunk /= 2) {
+    for (size_t i = 0; i + chunk <= values.size(); ) {
+      std::vector<int> candidate(values.begin(), values.begin() + i);
+      candidate.insert(candidate.end(), values.begin() + i + chunk, values.end());
+      if (still_fails(candidate)) {
+        values = std::move(candidate);
+      } else {
+        i += chunk;
+      }
+    }
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    while (values[i] != 0) {
+      auto candidate = values;
+      candidate[i] += (candidate[i] > 0) ? -1 : +1;
+      if (!still_fails(candidate)) {
+        break;
+      }
+      values = std::move(candidate);
+    }
+  }
+  return values;
+}
+
+std::string to_string(const std::vector<int>& values) {
+  std::ostringstream out;
+  out << "{";
+  for (size_t i = 0; i < values.size(); ++i) {
+    out << (i ? ", " : "") << values[i];
+  }
+  out << "}";
+  return out.str();
+}
+
+void report_failure(const std::vector<int>& values) {
+  auto shrunk = shrink(values);
+  std::cerr << "balance_fuzz: mismatch on " << values.size()
+            << "-element input" << std::endl
+            << "shrunk input (" << shrunk.size() << " elements): "
+            << to_string(shrunk) << std::endl
+            << check(shrunk) << std::endl;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  auto values = decode(data, size);
+  if (!check(values).empty()) {
+    report_failure(values);
+    std::abort();
+  }
+  return 0;
+}
+
+#ifndef BALANCE_FUZZ_LIBFUZZER
+
+// Hand-picked inputs covering the edge cases in balance_test.cpp .
+std::vector<std::vector<int>> seed_corpus() {
+  return {
+    {},
+    {5},
+    {5, 6},
+    {8, 2, 8},
+    {1, 2, 3},
+    {0, 0, 0},
+    {-10, -9, -10},
+    {5, 2, -1, 8},
+    {0, 2, -1, 8},
+    {5, 2, -1, 0},
+    {8, 5, -5, 7},
+    {8, -2, -3, 5},
+    {6, -2, -5, 1},
+    {4, 3, -3, 2, 0, 8},
+    {4, 0, 2, -3, 3, 8},
+    {3, 2, -2, 3, -4, 4, 3},
+    {8, -1, -1, 2, 7, 8, -1, -1, 2, 7},
+    {5, 2, 5, 5, 2, 5},
+    {2, 4, 6, 8, 2, 4, 6, 8},
+  };
+}
+
+std::vector<int> random_input(std::mt19937& rng, size_t length) {
+  std::uniform_int_distribution<> randint(-10, +10);
+  std::vector<int> values;
+  for (size_t i = 0; i < length; ++i) {
+    values.push_back(randint(rng));
+  }
+  return values;
+}
+
+int write_corpus(const std::string& directory) {
+  auto corpus = seed_corpus();
+  for (size_t i = 0; i < corpus.size(); ++i) {
+    auto path = directory + "/seed_" + std::to_string(i);
+    std::ofstream out(path, std::ios::binary);
+    out << encode(corpus[i]);
+    if (!out) {
+      std::cerr << "balance_fuzz: error writing '" << path << "'" << std::endl;
+      return 1;
+    }
+  }
+  std::cout << "wrote " << corpus.size() << " seeds to " << directory << std::endl;
+  return 0;
+}
+
+// Check pseudo-random inputs of a fixed length for a fixed number of seconds
+// and report execs/sec, so the cost of fuzzing can be tracked as the
+// algorithms change.
+int throughput(double seconds, size_t length) {
+  std::mt19937 rng(0);
+  unsigned long long execs = 0;
+  Timer timer;
+  double elapsed;
+  while ((elapsed = timer.elapsed()) < seconds) {
+    auto values = random_input(rng, length);
+    if (!check(values).empty()) {
+      report_failure(values);
+      return 1;
+    }
+    ++execs;
+  }
+  std::cout << "length=" << length
+            << " execs=" << execs
+            << " elapsed=" << elapsed << " seconds"
+            << " execs/sec=" << (execs / elapsed) << std::endl;
+  return 0;
+}
+
+int fuzz(unsigned long long iterations, size_t max_length) {
+  for (auto& values : seed_corpus()) {
+    if (!check(values).empty()) {
+      report_failure(values);
+      return 1;
+    }
+  }
+
+  std::mt19937 rng(0); // Use a hardcoded seed for reproducibility between runs.
+  std::uniform_int_distribution<size_t> randlength(0, max_length);
+  Timer timer;
+  for (unsigned long long i = 0; i < iterations; ++i) {
+    auto values = random_input(rng, randlength(rng));
+    if (!check(values).empty()) {
+      report_failure(values);
+      return 1;
+    }
+  }
+  double elapsed = timer.elapsed();
+
+  std::cout << "balance_fuzz: " << iterations << " random inputs passed in "
+            << elapsed << " seconds (" << (iterations / elapsed)
+            << " execs/sec)" << std::endl;
+  return 0;
+}
+
+int main(int argc, char** argv) {
+
+  std::vector<std::string> arguments(argv, argv + argc);
+
+  if ((arguments.size() == 3) && (arguments[1] == "--write-corpus")) {
+    return write_corpus(arguments[2]);
+  }
+
+  if ((arguments.size() >= 2) && (arguments[1] == "--throughput")) {
+    double seconds = (arguments.size() > 2) ? std::stod(arguments[2]) : 5.0;
+    size_t length = (arguments.size() > 3) ? std::stoul(arguments[3]) : 64;
+    return throughput(seconds, length);
+  }
+
+  if ((arguments.size() <= 3) && !((arguments.size() >= 2) && (arguments[1][0] == '-'))) {
+    unsigned long long iterations = (arguments.size() > 1) ? std::stoull(arguments[1]) : 100000;
+    size_t max_length = (arguments.size() > 2) ? std::stoul(arguments[2]) : 64;
+    return fuzz(iterations, max_length);
+  }
+
+  std::cout << "balance_fuzz usage:" << std::endl << std::endl
+            << "    balance_fuzz [ITERATIONS] [MAX-LENGTH]" << std::endl
+            << "    balance_fuzz --throughput [SECONDS] [LENGTH]" << std::endl
+            << "    balance_fuzz --write-corpus <DIRECTORY>" << std::endl << std::endl;
+  return 1;
+}
+
+#endif // BALANCE_FUZZ_LIBFUZZER
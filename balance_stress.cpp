@@ -0,0 +1,339 @@
+///////////////////////////////////////////////////////////////////////////////
+// balance_stress.cpp
+//
+// Large-scale stress tier for the algorithms declared in balance.hpp .
+//
+// balance_test.cpp checks correctness on inputs of at most 1 million
+// elements. This program runs both algorithms on inputs of 10^7 to 10^9
+// elements, where each case has a wall-time budget and a peak memory (RSS)
+// budget. A case fails when it returns the wrong answer, or exceeds either
+// budget.
+//
+// Each case runs in its own child process, so that its peak RSS can be read
+// from getrusage (via wait4) independently of the other cases, and so that
+// several cases can run in parallel.
+//
+// How to use:
+//
+//    ./balance_stress [-j JOBS] [FILTER]
+//
+// JOBS defaults to the number of cores. When FILTER is given, only cases whose
+// name contains FILTER are run. Note that the largest cases need several GB of
+// memory each, so machines with little RAM may need a small JOBS.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "timer.hpp"
+
+#include "balance.hpp"
+
+// Every case builds an input of n elements with a known answer, times a
+// single call to one of the algorithms, and returns whether that call
+// returned the correct answer. The elapsed time of the call is written to
+// elapsed.
+using stress_function = bool (*)(size_t n, double& elapsed);
+
+bool find_dip_all_same(size_t n, double& elapsed) {
+  std::vector<int> big(n, 1);
+  Timer timer;
+  auto got = balance::find_dip(big);
+  elapsed = timer.elapsed();
+  return got == big.end();
+}
+
+bool find_dip_rotating(size_t n, double& elapsed) {
+  std::vector<int> big(n);
+  for (size_t i = 0; i < n; ++i) {
+    big[i] = 2 * int(i % 4);
+  }
+  Timer timer;
+  auto got = balance::find_dip(big);
+  elapsed = timer.elapsed();
+  return got == big.end();
+}
+
+bool find_dip_near_start(size_t n, double& elapsed) {
+  std::vector<int> big(n, 1);
+  big[1] = 8;
+  big[2] = 7;
+  big[3] = 8;
+  Timer timer;
+  auto got = balance::find_dip(big);
+  elapsed = timer.elapsed();
+  return got == big.begin() + 1;
+}
+
+bool longest_balanced_span_alternating(size_t n, double& elapsed) {
+  assert(n % 2 == 0);
+  std::vector<int> big(n);
+  for (size_t i = 0; i < n; ++i) {
+    big[i] = (i % 2) ? -1 : +1;
+  }
+  Timer timer;
+  auto got = balance::longest_balanced_span(big);
+  elapsed = timer.elapsed();
+  return got && (*got == balance::span(big.begin(), big.end()));
+}
+
+bool longest_balanced_span_single_zero(size_t n, double& elapsed) {
+  std::vector<int> big(n, 1);
+  size_t i = n / 2;
+  big[i] = 0;
+  Timer timer;
+  auto got = balance::longest_balanced_span(big);
+  elapsed = timer.elapsed();
+  return got && (*got == balance::span(big.begin() + i, big.begin() + i + 1));
+}
+
+class stress_case {
+private:
+  std::string name_;
+  stress_function function_;
+  size_t n_;
+  double max_seconds_;
+  long max_rss_mb_;
+
+public:
+
+  stress_case(std::string&& name,
+              stress_function function,
+              size_t n,
+              double max_seconds,
+              long max_rss_mb)
+  : name_(name), function_(function), n_(n), max_seconds_(max_seconds),
+    max_rss_mb_(max_rss_mb) {
+    assert(nullptr != function);
+    assert(max_seconds > 0);
+    assert(max_rss_mb > 0);
+  }
+
+  const std::string& name() const { return name_; }
+  stress_function function() const { return function_; }
+  size_t n() const { return n_; }
+  double max_seconds() const { return max_seconds_; }
+  long max_rss_mb() const { return max_rss_mb_; }
+};
+
+// Memory budgets are the size of the input vector plus headroom; an int is 4
+// bytes so 10^7 elements take about 40 MB.
+const std::vector<stress_case> stress_cases{
+  {"find_dip_all_same_1e7", find_dip_all_same, 10000000, 1.0, 100},
+  {"find_dip_rotating_1e7", find_dip_rotating, 10000000, 1.0, 100},
+  {"find_dip_near_start_1e8", find_dip_near_start, 100000000, 5.0, 500},
+  {"find_dip_all_same_1e8", find_dip_all_same, 100000000, 5.0, 500},
+  {"find_dip_rotating_1e9", find_dip_rotating, 1000000000, 30.0, 4200},
+  {"longest_balanced_span_alternating_1e7", longest_balanced_span_alternating, 10000000, 10.0, 500},
+  {"longest_balanced_span_single_zero_1e7", longest_balanced_span_single_zero, 10000000, 10.0, 1500},
+  {"longest_balanced_span_alternating_1e8", longest_balanced_span_alternating, 100000000, 60.0, 1000},
+};
+
+class stress_result {
+private:
+  bool is_correct_, timed_out_, crashed_;
+  double seconds_;
+  long rss_mb_;
+
+public:
+
+  stress_result(bool is_correct, bool timed_out, bool crashed, double seconds,
+                long rss_mb)
+  : is_correct_(is_correct), timed_out_(timed_out), crashed_(crashed),
+    seconds_(seconds), rss_mb_(rss_mb) { }
+
+  stress_result()
+  : stress_result(false, false, false, 0, 0) { }
+
+  bool is_correct() const { return is_correct_; }
+  bool timed_out() const { return timed_out_; }
+  bool crashed() const { return crashed_; }
+  double seconds() const { return seconds_; }
+  long rss_mb() const { return rss_mb_; }
+};
+
+// Message sent from a child process back to the parent over a pipe.
+struct child_report {
+  bool is_correct;
+  double seconds;
+};
+
+// Body of a child process; never returns.
+[[noreturn]] void run_child(const stress_case& the_case, int report_fd) {
+  // Kill the child if it runs far past its budget, so that a quadratic
+  // algorithm on 10^8 elements does not hang the whole tier. The budget
+  // itself is enforced by the parent.
+  alarm(unsigned(std::ceil(the_case.max_seconds())) * 2 + 1);
+
+  child_report report;
+  report.is_correct = the_case.function()(the_case.n(), report.seconds);
+  ssize_t written = write(report_fd, &report, sizeof(report));
+  _exit((written == sizeof(report)) ? 0 : 1);
+}
+
+class running_case {
+private:
+  const stress_case* the_case_;
+  int report_fd_;
+
+public:
+
+  running_case(const stress_case* the_case, int report_fd)
+  : the_case_(the_case), report_fd_(report_fd) { }
+
+  running_case()
+  : running_case(nullptr, -1) { }
+
+  const stress_case& the_case() const {
+    assert(the_case_);
+    return *the_case_;
+  }
+  int report_fd() const { return report_fd_; }
+};
+
+void print_bar() {
+  std::cout << std::string(79, '-') << std::endl;
+}
+
+// Print a description of result, and return whether the case passed.
+bool print_result(const stress_case& the_case, const stress_result& result) {
+  bool within_time = !result.timed_out() && (result.seconds() <= the_case.max_seconds()),
+       within_rss = (result.rss_mb() <= the_case.max_rss_mb()),
+       passed = result.is_correct() && within_time && within_rss;
+
+  std::cout << (passed ? "[  PASS  ] " : "[  FAIL  ] ")
+            << the_case.name() << std::endl
+            << "           n=" << the_case.n()
+            << " time=" << std::fixed << std::setprecision(3)
+            << result.seconds() << "/" << the_case.max_seconds() << " s"
+            << " rss=" << result.rss_mb() << "/" << the_case.max_rss_mb() << " MB"
+            << std::defaultfloat << std::endl;
+  if (result.timed_out()) {
+    std::cout << "           killed after exceeding time budget" << std::endl;
+  } else if (result.crashed()) {
+    std::cout << "           child process crashed" << std::endl;
+  } else if (!result.is_correct()) {
+    std::cout << "           wrong answer" << std::endl;
+  } else if (!within_time) {
+    std::cout << "           exceeded time budget" << std::endl;
+  } else if (!within_rss) {
+    std::cout << "           exceeded memory budget" << std::endl;
+  }
+  return passed;
+}
+
+int main(int argc, char** argv) {
+
+  std::vector<std::string> arguments(argv, argv + argc);
+
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  std::string filter;
+  for (size_t i = 1; i < arguments.size(); ++i) {
+    if ((arguments[i] == "-j") && (i + 1 < arguments.size())) {
+      jobs = std::max(1, std::stoi(arguments[++i]));
+    } else if (filter.empty() && (arguments[i][0] != '-')) {
+      filter = arguments[i];
+    } else {
+      std::cout << "balance_stress usage:" << std::endl << std::endl
+                << "    balance_stress [-j JOBS] [FILTER]" << std::endl << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<const stress_case*> pending;
+  for (auto& the_case : stress_cases) {
+    if (the_case.name().find(filter) != std::string::npos) {
+      pending.push_back(&the_case);
+    }
+  }
+  if (pending.empty()) {
+    std::cerr << "balance_stress: no case matches '" << filter << "'" << std::endl;
+    return 1;
+  }
+
+  print_bar();
+  std::cout << "running " << pending.size() << " stress cases, "
+            << jobs << " at a time" << std::endl;
+  print_bar();
+
+  Timer total_timer;
+  std::map<pid_t, running_case> running;
+  size_t next = 0;
+  unsigned passed = 0;
+  while ((next < pending.size()) || !running.empty()) {
+
+    while ((next < pending.size()) && (running.size() < jobs)) {
+      auto the_case = pending[next++];
+      int fds[2];
+      if (0 != pipe(fds)) {
+        std::perror("balance_stress: pipe");
+        return 1;
+      }
+      std::cout.flush();
+      pid_t pid = fork();
+      if (pid < 0) {
+        std::perror("balance_stress: fork");
+        return 1;
+      }
+      if (0 == pid) {
+        close(fds[0]);
+        run_child(*the_case, fds[1]);
+      }
+      close(fds[1]);
+      running[pid] = running_case(the_case, fds[0]);
+    }
+
+    int status;
+    struct rusage usage;
+    pid_t pid = wait4(-1, &status, 0, &usage);
+    if (pid < 0) {
+      std::perror("balance_stress: wait4");
+      return 1;
+    }
+    auto iter = running.find(pid);
+    assert(iter != running.end());
+    auto& the_case = iter->second.the_case();
+
+    child_report report{false, 0};
+    bool reported = (WIFEXITED(status) && (0 == WEXITSTATUS(status)) &&
+                     (sizeof(report) == read(iter->second.report_fd(), &report, sizeof(report))));
+    close(iter->second.report_fd());
+    running.erase(iter);
+
+    bool timed_out = (WIFSIGNALED(status) && (SIGALRM == WTERMSIG(status)));
+    if (!reported) {
+      report.is_correct = false;
+      report.seconds = timed_out ? (2 * the_case.max_seconds()) : 0;
+    }
+
+    // On Linux ru_maxrss is measured in kilobytes.
+    stress_result result(report.is_correct, timed_out, !reported && !timed_out,
+                         report.seconds, usage.ru_maxrss / 1024);
+    if (print_result(the_case, result)) {
+      ++passed;
+    }
+  }
+
+  print_bar();
+  std::cout << passed << " / " << pending.size() << " stress cases passed in "
+            << total_timer.elapsed() << " seconds" << std::endl;
+  print_bar();
+
+  return (passed == pending.size()) ? 0 : 1;
+}
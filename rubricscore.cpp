@@ -8,15 +8,23 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
 #include <exception>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <boost/property_tree/json_parser.hpp>
-#include <boost/property_tree/xml_parser.hpp>
+
+#include "timer.hpp"
 
 class parse_exception : public std::exception {
 private:
@@ -33,7 +41,8 @@ public:
 class testsuite {
 private:
   std::string name_;
-  unsigned tests_, failures_, disabled_, errors_, time_;
+  unsigned tests_, failures_, disabled_, errors_;
+  double time_;
 
 public:
 
@@ -42,7 +51,7 @@ public:
             unsigned failures,
             unsigned disabled,
             unsigned errors,
-            unsigned time)
+            double time)
   : name_(name), tests_(tests), failures_(failures), disabled_(disabled),
     errors_(errors), time_(time) { }
 
@@ -54,43 +63,264 @@ public:
   unsigned failures() const { return failures_; }
   unsigned disabled() const { return disabled_; }
   unsigned errors() const { return errors_; }
-  unsigned time() const { return time_; }
+  // Elapsed time in seconds; googletest reports fractions of a second.
+  double time() const { return time_; }
 };
 
 using test_results = std::map<std::string, testsuite>;
 
+// SAX-style scanner over googletest XML. Rather than building a DOM of the
+// whole report, it reads the input one character at a time and only keeps the
+// attributes of each <testsuite> start tag; everything else, including
+// <testcase> elements and failure messages, is skipped.
+class testsuite_scanner {
+private:
+  using traits = std::char_traits<char>;
+  using attributes = std::map<std::string, std::string>;
+
+  std::streambuf* in_;
+  bool saw_testsuites_;
+
+  int get() { return in_->sbumpc(); }
+  int peek() { return in_->sgetc(); }
+
+  static bool is_space(int c) {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+  }
+
+  int get_or_throw() {
+    int c = get();
+    if (traits::eq_int_type(c, traits::eof())) {
+      throw parse_exception("error parsing XML: unexpected end of file");
+    }
+    return c;
+  }
+
+  void skip_space() {
+    while (is_space(peek())) {
+      get();
+    }
+  }
+
+  // Consume input up to and including terminator.
+  void skip_past(const std::string& terminator) {
+    std::string tail;
+    while (tail != terminator) {
+      tail.push_back(char(get_or_throw()));
+      if (tail.size() > terminator.size()) {
+        tail.erase(tail.begin());
+      }
+    }
+  }
+
+  std::string read_name() {
+    std::string name;
+    for (int c = peek();
+         !is_space(c) && (c != '=') && (c != '/') && (c != '>') &&
+           !traits::eq_int_type(c, traits::eof());
+         c = peek()) {
+      name.push_back(char(get()));
+    }
+    if (name.empty()) {
+      throw parse_exception("error parsing XML: expected a name");
+    }
+    return name;
+  }
+
+  // Append the UTF-8 encoding of code_point to out.
+  static void append_utf8(std::string& out, unsigned long code_point) {
+    if (code_point < 0x80) {
+      out.push_back(char(code_point));
+    } else if (code_point < 0x800) {
+      out.push_back(char(0xC0 | (code_point >> 6)));
+      out.push_back(char(0x80 | (code_point & 0x3F)));
+    } else if (code_point < 0x10000) {
+      out.push_back(char(0xE0 | (code_point >> 12)));
+      out.push_back(char(0x80 | ((code_point >> 6) & 0x3F)));
+      out.push_back(char(0x80 | (code_point & 0x3F)));
+    } else {
+      out.push_back(char(0xF0 | (code_point >> 18)));
+      out.push_back(char(0x80 | ((code_point >> 12) & 0x3F)));
+      out.push_back(char(0x80 | ((code_point >> 6) & 0x3F)));
+      out.push_back(char(0x80 | (code_point & 0x3F)));
+    }
+  }
+
+  // Read the entity following a '&', and append the character it stands for.
+  void read_entity(std::string& out) {
+    std::string entity;
+    for (int c = get_or_throw(); c != ';'; c = get_or_throw()) {
+      entity.push_back(char(c));
+    }
+    if (entity == "lt") {
+      out.push_back('<');
+    } else if (entity == "gt") {
+      out.push_back('>');
+    } else if (entity == "amp") {
+      out.push_back('&');
+    } else if (entity == "quot") {
+      out.push_back('"');
+    } else if (entity == "apos") {
+      out.push_back('\'');
+    } else if ((entity.size() > 1) && (entity[0] == '#')) {
+      bool hex = (entity[1] == 'x');
+      try {
+        append_utf8(out, std::stoul(entity.substr(hex ? 2 : 1), nullptr, hex ? 16 : 10));
+      } catch (std::exception&) {
+        throw parse_exception("error parsing XML: invalid character reference &" + entity + ";");
+      }
+    } else {
+      throw parse_exception("error parsing XML: unknown entity &" + entity + ";");
+    }
+  }
+
+  std::string read_quoted_value() {
+    int quote = get_or_throw();
+    if ((quote != '"') && (quote != '\'')) {
+      throw parse_exception("error parsing XML: attribute value is not quoted");
+    }
+    std::string value;
+    for (int c = get_or_throw(); c != quote; c = get_or_throw()) {
+      if (c == '&') {
+        read_entity(value);
+      } else {
+        value.push_back(char(c));
+      }
+    }
+    return value;
+  }
+
+  // Read the rest of a start or end tag, after its name. The attributes are
+  // stored in found when it is non-null, and skipped otherwise.
+  void read_rest_of_tag(attributes* found) {
+    for (;;) {
+      skip_space();
+      int c = get_or_throw();
+      if (c == '>') {
+        return;
+      }
+      if (c == '/') {
+        continue;
+      }
+      in_->sungetc();
+      auto name = read_name();
+      skip_space();
+      if (get_or_throw() != '=') {
+        throw parse_exception("error parsing XML: attribute '" + name + "' has no value");
+      }
+      skip_space();
+      auto value = read_quoted_value();
+      if (found) {
+        (*found)[name] = std::move(value);
+      }
+    }
+  }
+
+public:
+
+  explicit testsuite_scanner(std::streambuf* in)
+  : in_(in), saw_testsuites_(false) {
+    assert(nullptr != in);
+  }
+
+  // Whether a <testsuites> element has been seen so far.
+  bool saw_testsuites() const { return saw_testsuites_; }
+
+  // Advance to the next <testsuite> start tag and store its attributes in
+  // found. Returns false at the end of the input.
+  //
+  // throws parse_exception on malformed XML
+  bool next(attributes& found) {
+    for (;;) {
+      int c = get();
+      if (traits::eq_int_type(c, traits::eof())) {
+        return false;
+      }
+      if (c != '<') {
+        continue;
+      }
+      c = peek();
+      if (c == '?') {
+        skip_past("?>");
+      } else if (c == '!') {
+        get();
+        if (peek() == '-') {
+          skip_past("-->");
+        } else if (peek() == '[') {
+          skip_past("]]>");
+        } else {
+          skip_past(">");
+        }
+      } else if (c == '/') {
+        skip_past(">");
+      } else {
+        auto name = read_name();
+        if (name == "testsuites") {
+          saw_testsuites_ = true;
+        }
+        if (name == "testsuite") {
+          found.clear();
+          read_rest_of_tag(&found);
+          return true;
+        }
+        read_rest_of_tag(nullptr);
+      }
+    }
+  }
+};
+
+// Convert the attribute called key to a T, or return default_value when the
+// attribute is missing.
+//
+// throws parse_exception when the attribute is not a valid T
+template <typename T>
+T attribute_value(const std::map<std::string, std::string>& attributes,
+                  const std::string& key,
+                  T default_value) {
+  auto iter = attributes.find(key);
+  if (iter == attributes.end()) {
+    return default_value;
+  }
+  std::istringstream stream(iter->second);
+  T value;
+  stream >> value;
+  if (stream.fail() || !(stream >> std::ws).eof()) {
+    throw parse_exception("error decoding XML: attribute " + key + "=\"" +
+                          iter->second + "\" is not a valid number");
+  }
+  return value;
+}
+
 // throws parse_exception on I/O or parse error
 test_results load_test_results(const std::string& googletest_xml_path) {
 
-  boost::property_tree::ptree tree;
-  try {
-    boost::property_tree::read_xml(googletest_xml_path, tree);
-  } catch (boost::property_tree::xml_parser_error e) {
-    throw parse_exception("error parsing XML: " + e.message());
+  std::ifstream in(googletest_xml_path, std::ios::binary);
+  if (!in) {
+    throw parse_exception("error parsing XML: cannot open file");
   }
 
+  testsuite_scanner scanner(in.rdbuf());
+  std::map<std::string, std::string> attributes;
   test_results result;
-  try {
-    auto testsuites = tree.get_child("testsuites");
-    for (auto& child : testsuites) {
-      if (child.first == "testsuite") {
-        auto& attributes = child.second.get_child("<xmlattr>");
-        std::string name = attributes.get("name", "");
-        unsigned tests = attributes.get<unsigned>("tests", 0),
-                 failures = attributes.get<unsigned>("failures", 0),
-                 disabled = attributes.get<unsigned>("disabled", 0),
-                 errors = attributes.get<unsigned>("errors", 0),
-                 time = attributes.get<unsigned>("time", 0);
-        if (name.empty()) {
-          throw parse_exception("error parsing XML: a <testsuite> has no name=");
-        }
-        result[name] = testsuite(std::move(name), tests, failures, disabled, errors, time);
-      }
+  while (scanner.next(attributes)) {
+    std::string name = attributes["name"];
+    unsigned tests = attribute_value<unsigned>(attributes, "tests", 0),
+             failures = attribute_value<unsigned>(attributes, "failures", 0),
+             disabled = attribute_value<unsigned>(attributes, "disabled", 0),
+             errors = attribute_value<unsigned>(attributes, "errors", 0);
+    double time = attribute_value<double>(attributes, "time", 0);
+    if (name.empty()) {
+      throw parse_exception("error parsing XML: a <testsuite> has no name=");
     }
-  } catch (boost::property_tree::ptree_error e) {
-    throw parse_exception(std::string("error decoding XML: ") + e.what());
+    result[name] = testsuite(std::move(name), tests, failures, disabled, errors, time);
   }
 
+  if (in.bad()) {
+    throw parse_exception("error parsing XML: I/O error");
+  }
+  if (!scanner.saw_testsuites()) {
+    throw parse_exception("error decoding XML: does not contain a <testsuites> node");
+  }
   if (result.empty()) {
     throw parse_exception("error parsing XML: does not contain any <testsuite> nodes");
   }
@@ -102,17 +332,24 @@ class rubric_item {
 private:
   std::string name_;
   unsigned points_;
+  std::optional<double> max_seconds_;
 
 public:
 
-  rubric_item(std::string&& name, unsigned points)
-  : name_(name), points_(points) { }
+  rubric_item(std::string&& name,
+              unsigned points,
+              std::optional<double> max_seconds = std::nullopt)
+  : name_(name), points_(points), max_seconds_(max_seconds) { }
 
   rubric_item()
   : rubric_item(std::string(), 0) { }
 
   const std::string& name() const { return name_; }
   unsigned points() const { return points_; }
+
+  // Time budget in seconds, if the item has one. When present, the points are
+  // only earned when the testsuite passes within this many seconds.
+  const std::optional<double>& max_seconds() const { return max_seconds_; }
 };
 
 using rubric = std::vector<rubric_item>;
@@ -127,14 +364,31 @@ rubric load_rubric(const std::string& json_path) {
     throw parse_exception("error parsing JSON: " + e.message());
   }
 
+  // Each key maps either to a number of points, e.g.
+  //   "find_dip_trivial_cases" : 3
+  // or to an object with points and a time budget, e.g.
+  //   "find_dip_trivial_cases" : { "points" : 3, "max_seconds" : 0.25 }
   rubric result;
   for (auto& child : tree) {
     auto& name = child.first;
-    auto points = child.second.get_value<unsigned>(0);
+    unsigned points;
+    std::optional<double> max_seconds;
+    if (child.second.empty()) {
+      points = child.second.get_value<unsigned>(0);
+    } else {
+      points = child.second.get<unsigned>("points", 0);
+      auto budget = child.second.get_child_optional("max_seconds");
+      if (budget) {
+        max_seconds = budget->get_value<double>(0);
+        if (!(*max_seconds > 0)) {
+          throw parse_exception("key '" + name + "' has a max_seconds that is not a positive number");
+        }
+      }
+    }
     if (0 == points) {
       throw parse_exception("key '" + name + "' does not map to a positive integer");
     }
-    result.emplace_back(std::string(name), points);
+    result.emplace_back(std::string(name), points, max_seconds);
   }
 
   if (result.empty()) {
@@ -148,17 +402,18 @@ class rubric_item_score {
 private:
   const rubric_item* item_;
   bool is_correct_;
+  double seconds_;
 
 public:
 
-  rubric_item_score(const rubric_item* item, bool is_correct)
-  : item_(item), is_correct_(is_correct) {
+  rubric_item_score(const rubric_item* item, bool is_correct, double seconds)
+  : item_(item), is_correct_(is_correct), seconds_(seconds) {
     assert(nullptr != item);
     assert(is_valid());
   }
 
   rubric_item_score()
-  : item_(nullptr), is_correct_(false) {
+  : item_(nullptr), is_correct_(false), seconds_(0) {
     assert(!is_valid());
   }
 
@@ -169,11 +424,24 @@ public:
     return *item_;
   }
 
+  // Whether the testsuite passed, regardless of its time budget.
   bool is_correct() const {
     assert(is_valid());
     return is_correct_;
   }
 
+  // Measured time of the testsuite, in seconds.
+  double seconds() const {
+    assert(is_valid());
+    return seconds_;
+  }
+
+  bool is_within_budget() const {
+    assert(is_valid());
+    auto& budget = item_->max_seconds();
+    return !budget || (seconds_ <= *budget);
+  }
+
   unsigned possible_points() const {
     assert(is_valid());
     return item_->points();
@@ -181,7 +449,7 @@ public:
 
   unsigned earned_points() const {
     assert(is_valid());
-    if (is_correct_) {
+    if (is_correct_ && is_within_budget()) {
       return possible_points();
     } else {
       return 0;
@@ -211,7 +479,7 @@ rubric_score evaluate_score(const rubric& the_rubric,
     auto& suite = suite_iter->second;
     assert(name == suite.name());
     bool worked = (0 == suite.failures());
-    result.emplace_back(&item, worked);
+    result.emplace_back(&item, worked, suite.time());
   }
   return result;
 }
@@ -241,8 +509,21 @@ void print_score(const rubric_score& the_score) {
               << std::right
               << std::setw(4) << earned
               << " / "
-              << std::setw(4) << possible
-              << std::endl;
+              << std::setw(4) << possible;
+    auto& budget = score.item().max_seconds();
+    if (budget) {
+      std::cout << std::fixed << std::setprecision(3)
+                << "    time "
+                << std::setw(7) << score.seconds()
+                << " / "
+                << std::setw(7) << *budget
+                << " s"
+                << std::defaultfloat;
+      if (score.is_correct() && !score.is_within_budget()) {
+        std::cout << " (over budget)";
+      }
+    }
+    std::cout << std::endl;
   }
 
   std::cout << line << std::endl
@@ -255,6 +536,300 @@ void print_score(const rubric_score& the_score) {
   std::cout << line << std::endl << std::endl;
 }
 
+// The outcome of scoring one googletest XML report in batch mode. Either the
+// report was scored, or it could not be loaded and error describes why.
+class batch_report {
+private:
+  std::string path_;
+  rubric_score score_;
+  std::string error_;
+
+public:
+
+  batch_report(std::string&& path, rubric_score&& score, std::string&& error)
+  : path_(path), score_(score), error_(error) { }
+
+  batch_report()
+  : batch_report(std::string(), rubric_score(), std::string()) { }
+
+  const std::string& path() const { return path_; }
+  const rubric_score& score() const { return score_; }
+  const std::string& error() const { return error_; }
+  bool is_ok() const { return error_.empty(); }
+
+  unsigned earned_points() const {
+    unsigned total = 0;
+    for (auto& item_score : score_) {
+      total += item_score.earned_points();
+    }
+    return total;
+  }
+};
+
+using batch_results = std::vector<batch_report>;
+
+// Expand the inputs given on the command line into a list of report paths.
+// A directory stands for every .xml file beneath it, in sorted order, and an
+// argument of the form @FILE stands for the paths listed in FILE, one per
+// line. Any other argument is a report path itself.
+//
+// throws parse_exception on I/O error
+std::vector<std::string> gather_report_paths(const std::vector<std::string>& inputs) {
+  namespace fs = std::filesystem;
+
+  std::vector<std::string> result;
+  for (auto& input : inputs) {
+    if (!input.empty() && (input[0] == '@')) {
+      auto list_path = input.substr(1);
+      std::ifstream list(list_path);
+      if (!list) {
+        throw parse_exception("cannot open file list '" + list_path + "'");
+      }
+      for (std::string line; std::getline(list, line); ) {
+        if (!line.empty() && (line.back() == '\r')) {
+          line.pop_back();
+        }
+        if (!line.empty()) {
+          result.push_back(line);
+        }
+      }
+    } else if (fs::is_directory(input)) {
+      std::vector<std::string> found;
+      try {
+        for (auto& entry : fs::recursive_directory_iterator(input)) {
+          if (entry.is_regular_file() && (entry.path().extension() == ".xml")) {
+            found.push_back(entry.path().string());
+          }
+        }
+      } catch (fs::filesystem_error& e) {
+        throw parse_exception(std::string("error reading directory: ") + e.what());
+      }
+      std::sort(found.begin(), found.end());
+      result.insert(result.end(), found.begin(), found.end());
+    } else {
+      result.push_back(input);
+    }
+  }
+  return result;
+}
+
+// Score every report at paths against the_rubric, using jobs threads. The
+// rubric is only read, so every thread shares the one copy. Reports that
+// cannot be loaded are recorded with an error instead of stopping the batch.
+batch_results score_batch(const rubric& the_rubric,
+                          const std::vector<std::string>& paths,
+                          unsigned jobs) {
+  assert(jobs > 0);
+
+  batch_results result(paths.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < paths.size(); i = next++) {
+      rubric_score score;
+      std::string error;
+      try {
+        score = evaluate_score(the_rubric, load_test_results(paths[i]));
+      } catch (parse_exception& e) {
+        error = e.what();
+      }
+      result[i] = batch_report(std::string(paths[i]), std::move(score), std::move(error));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < std::min<size_t>(jobs, paths.size()); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+
+std::string csv_field(const std::string& value) {
+  if (value.find_first_of(",\"\r\n") == std::string::npos) {
+    return value;
+  }
+  std::string quoted = "\"";
+  for (char c : value) {
+    if (c == '"') {
+      quoted.push_back('"');
+    }
+    quoted.push_back(c);
+  }
+  return quoted + "\"";
+}
+
+std::string json_string(const std::string& value) {
+  std::ostringstream out;
+  out << '"';
+  for (unsigned char c : value) {
+    switch (c) {
+    case '"':  out << "\\\""; break;
+    case '\\': out << "\\\\"; break;
+    case '\n': out << "\\n"; break;
+    case '\r': out << "\\r"; break;
+    case '\t': out << "\\t"; break;
+    default:
+      if (c < 0x20) {
+        out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << unsigned(c)
+            << std::dec << std::setfill(' ');
+      } else {
+        out << c;
+      }
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+// One row per report, with one column of earned points per rubric item.
+void write_batch_csv(std::ostream& out,
+                     const rubric& the_rubric,
+                     const batch_results& the_results) {
+  unsigned total_possible_points = 0;
+  out << "path";
+  for (auto& item : the_rubric) {
+    out << "," << csv_field(item.name());
+    total_possible_points += item.points();
+  }
+  out << ",total,possible,error" << std::endl;
+
+  for (auto& report : the_results) {
+    out << csv_field(report.path());
+    for (auto& item_score : report.score()) {
+      out << "," << item_score.earned_points();
+    }
+    if (!report.is_ok()) {
+      for (size_t i = 0; i < the_rubric.size(); ++i) {
+        out << ",";
+      }
+    }
+    out << "," << (report.is_ok() ? std::to_string(report.earned_points()) : "")
+        << "," << total_possible_points
+        << "," << csv_field(report.error())
+        << std::endl;
+  }
+}
+
+// A JSON array with one object per report.
+void write_batch_json(std::ostream& out,
+                      const rubric& the_rubric,
+                      const batch_results& the_results) {
+  unsigned total_possible_points = 0;
+  for (auto& item : the_rubric) {
+    total_possible_points += item.points();
+  }
+
+  out << "[" << std::endl;
+  for (size_t i = 0; i < the_results.size(); ++i) {
+    auto& report = the_results[i];
+    out << "  { \"path\" : " << json_string(report.path());
+    if (report.is_ok()) {
+      out << ", \"items\" : {";
+      for (size_t j = 0; j < report.score().size(); ++j) {
+        auto& item_score = report.score()[j];
+        out << (j ? ", " : " ")
+            << json_string(item_score.item().name()) << " : " << item_score.earned_points();
+      }
+      out << " }, \"total\" : " << report.earned_points();
+    } else {
+      out << ", \"error\" : " << json_string(report.error());
+    }
+    out << ", \"possible\" : " << total_possible_points << " }"
+        << ((i + 1 < the_results.size()) ? "," : "") << std::endl;
+  }
+  out << "]" << std::endl;
+}
+
+int batch_main(const std::vector<std::string>& arguments) {
+
+  assert((arguments.size() >= 2) && (arguments[1] == "--batch"));
+
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  size_t first = 2;
+  if ((arguments.size() > first + 1) && (arguments[first] == "-j")) {
+    try {
+      jobs = std::max(1, std::stoi(arguments[first + 1]));
+    } catch (std::exception&) {
+      jobs = 0;
+    }
+    first += 2;
+  }
+
+  if ((0 == jobs) || (arguments.size() < first + 3)) {
+    std::cout << "rubricscore usage:" << std::endl << std::endl
+              << "    rubricscore --batch [-j JOBS] <RUBRIC-JSON-PATH> <OUTPUT-PATH> <GTEST-XML-PATH | DIRECTORY | @FILE-LIST>..."
+              << std::endl << std::endl
+              << "OUTPUT-PATH is written as JSON when it ends in .json, and as CSV otherwise;"
+              << std::endl
+              << "use - for CSV on standard output." << std::endl << std::endl;
+    return 1;
+  }
+
+  auto& json_path = arguments[first];
+  auto& output_path = arguments[first + 1];
+  std::vector<std::string> inputs(arguments.begin() + first + 2, arguments.end());
+
+  rubric the_rubric;
+  try {
+    the_rubric = load_rubric(json_path);
+  } catch (parse_exception& e) {
+    std::cerr << "rubricscore: error loading rubric JSON '" << json_path
+              << "': " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::vector<std::string> paths;
+  try {
+    paths = gather_report_paths(inputs);
+  } catch (parse_exception& e) {
+    std::cerr << "rubricscore: " << e.what() << std::endl;
+    return 1;
+  }
+
+  Timer timer;
+  auto the_results = score_batch(the_rubric, paths, jobs);
+  double elapsed = timer.elapsed();
+
+  std::ofstream file;
+  if (output_path != "-") {
+    file.open(output_path);
+    if (!file) {
+      std::cerr << "rubricscore: cannot open output '" << output_path << "'" << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = file.is_open() ? file : std::cout;
+  bool json = (output_path.size() >= 5) &&
+              (0 == output_path.compare(output_path.size() - 5, 5, ".json"));
+  if (json) {
+    write_batch_json(out, the_rubric, the_results);
+  } else {
+    write_batch_csv(out, the_rubric, the_results);
+  }
+  out.flush();
+  if (!out) {
+    std::cerr << "rubricscore: error writing output '" << output_path << "'" << std::endl;
+    return 1;
+  }
+
+  size_t errors = 0;
+  for (auto& report : the_results) {
+    if (!report.is_ok()) {
+      ++errors;
+      std::cerr << "rubricscore: error scoring '" << report.path()
+                << "': " << report.error() << std::endl;
+    }
+  }
+  std::cerr << "rubricscore: scored " << (the_results.size() - errors) << " of "
+            << the_results.size() << " reports with " << jobs << " threads in "
+            << elapsed << " seconds" << std::endl;
+
+  return (0 == errors) ? 0 : 1;
+}
+
 int main(int argc, char** argv) {
 
   // convert arguments to std::string
@@ -263,9 +838,15 @@ int main(int argc, char** argv) {
     arguments.emplace_back(argv[i]);
   }
 
+  if ((arguments.size() >= 2) && (arguments[1] == "--batch")) {
+    return batch_main(arguments);
+  }
+
   if (arguments.size() != 3) {
     std::cout << "rubricscore usage:" << std::endl << std::endl
-              << "    rubricscore <RUBRIC-JSON-PATH> <GTEST-XML-PATH>" << std::endl << std::endl;
+              << "    rubricscore <RUBRIC-JSON-PATH> <GTEST-XML-PATH>" << std::endl
+              << "    rubricscore --batch [-j JOBS] <RUBRIC-JSON-PATH> <OUTPUT-PATH> <GTEST-XML-PATH | DIRECTORY | @FILE-LIST>..."
+              << std::endl << std::endl;
     return 1;
   }
 